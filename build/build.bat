@@ -1,2 +1,2 @@
-gcc ../*.c -std=c99 -Dmain4=main -lpng -o FE4.exe
-gcc ../*.c -std=c99 -Dmain5=main -lpng -o FE5.exe
+gcc ../*.c -std=c99 -mssse3 -Dmain4=main -lpng -o FE4.exe
+gcc ../*.c -std=c99 -mssse3 -Dmain5=main -lpng -o FE5.exe
@@ -2,11 +2,13 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
 #include "decompress.h"
 #include "graphic.h"
+#include "scale.h"
 
 struct tile {
     struct tile *next;
@@ -19,6 +21,9 @@ struct tile {
     bool hasSpeakArea;
     uint8_t dataPixelsSpeak1[48 * 64 / 2];
     uint8_t dataPixelsSpeak2[48 * 64 / 2];
+    uint8_t *dataPixelsDisplayScaled;
+    uint8_t *dataPixelsSpeak1Scaled;
+    uint8_t *dataPixelsSpeak2Scaled;
 };
 
 struct palette {
@@ -46,6 +51,22 @@ static char* filepath_sprintf(char *template, int index) {
 }
 
 int main4(int argc, char **argv) {
+    // 参数: [放大倍数(2/3/4)] [epx]
+    int scale = 1;
+    bool scaleEpx = false;
+    if (argc > 1) {
+        char *end;
+        scale = strtol(argv[1], &end, 10);
+        if (*end != '\0') scale = 0;
+    }
+    if (argc > 2) {
+        scaleEpx = strcmp(argv[2], "epx") == 0;
+    }
+    if (argc > 3 || scale < 1 || scale > 4 || (argc > 2 && (!scaleEpx || scale == 1))) {
+        printf("Usage: %s [2|3|4] [epx]\n", argv[0]);
+        return -1;
+    }
+
     FILE *rom = fopen(".\\FE4.sfc", "rb");
     fseek(rom, 0, SEEK_END);
     if (ftell(rom) != 0x400000) {
@@ -126,6 +147,31 @@ int main4(int argc, char **argv) {
         tile = tile->next;
     }
 
+    // 放大(在调色板展开前处理索引色像素)
+    if (scale > 1) {
+        int scaledSize = 48 * scale * 64 * scale / 2;
+        const void *frameSources[portraitCount * 3];
+        void *frameTargets[portraitCount * 3];
+        int frameCount = 0;
+        for (tile = tiles->next; tile->next != NULL; tile = tile->next) {
+            tile->dataPixelsDisplayScaled = malloc(scaledSize);
+            frameSources[frameCount] = tile->dataPixelsDisplay;
+            frameTargets[frameCount++] = tile->dataPixelsDisplayScaled;
+            if (tile->hasSpeakArea) {
+                tile->dataPixelsSpeak1Scaled = malloc(scaledSize);
+                frameSources[frameCount] = tile->dataPixelsSpeak1;
+                frameTargets[frameCount++] = tile->dataPixelsSpeak1Scaled;
+                tile->dataPixelsSpeak2Scaled = malloc(scaledSize);
+                frameSources[frameCount] = tile->dataPixelsSpeak2;
+                frameTargets[frameCount++] = tile->dataPixelsSpeak2Scaled;
+            }
+        }
+        double elapsed = bmp_pixels_scale_frames(frameSources, frameTargets, frameCount,
+            48, 64, scale, scaleEpx);
+        printf("Scaled %d frames x%d (%s): %.3f us per frame\n",
+            frameCount, scale, scaleEpx ? "epx" : "nearest", elapsed / frameCount);
+    }
+
     // 读取头像调色板表(每项为3字节指针)
     fseek(rom, 0x0AB7E1, SEEK_SET);  // 调色板表地址
     for (int i = 0; i < portraitCount; ++i) {
@@ -165,6 +211,10 @@ int main4(int argc, char **argv) {
     mkdir(".\\FE4\\bmp");
     mkdir(".\\FE4\\png");
     mkdir(".\\FE4\\png_speak");
+    if (scale > 1) {
+        mkdir(".\\FE4\\png_scaled");
+        mkdir(".\\FE4\\png_speak_scaled");
+    }
     for (int i = 0; i < portraitCount; ++i) {
         // 输出BMP(128x32)
         bmp_write_file(filepath_sprintf(".\\FE4\\bmp\\%03d.bmp", i),
@@ -179,6 +229,20 @@ int main4(int argc, char **argv) {
             png_write_file(filepath_sprintf(".\\FE4\\png_speak\\%03d_2.png", i),
                 portraits[i].palette->dataBmp, portraits[i].tile->dataPixelsSpeak2, 48, 64);
         }
+        // 输出放大后的PNG
+        if (scale > 1) {
+            png_write_file(filepath_sprintf(".\\FE4\\png_scaled\\%03d.png", i),
+                portraits[i].palette->dataBmp, portraits[i].tile->dataPixelsDisplayScaled,
+                48 * scale, 64 * scale);
+            if (portraits[i].tile->hasSpeakArea) {
+                png_write_file(filepath_sprintf(".\\FE4\\png_speak_scaled\\%03d_1.png", i),
+                    portraits[i].palette->dataBmp, portraits[i].tile->dataPixelsSpeak1Scaled,
+                    48 * scale, 64 * scale);
+                png_write_file(filepath_sprintf(".\\FE4\\png_speak_scaled\\%03d_2.png", i),
+                    portraits[i].palette->dataBmp, portraits[i].tile->dataPixelsSpeak2Scaled,
+                    48 * scale, 64 * scale);
+            }
+        }
     }
 
     fclose(rom);
@@ -0,0 +1,247 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "scale.h"
+
+// 像素格式同BMP(4bpp，高4位在左)，放大后仍为索引色，调色板不变
+
+// 单字节横向放大: 2个像素 -> 2*scale个像素(scale字节)
+static inline void scale_byte_nearest(uint8_t src, uint8_t *dst, int scale) {
+    uint8_t hi = (src >> 4) * 0x11;
+    uint8_t lo = (src & 0x0F) * 0x11;
+    switch (scale) {
+        case 2: dst[0] = hi; dst[1] = lo; break;
+        case 3: dst[0] = hi; dst[1] = src; dst[2] = lo; break;
+        case 4: dst[0] = hi; dst[1] = hi; dst[2] = lo; dst[3] = lo; break;
+    }
+}
+
+#if defined(__SSE2__)
+// 16字节横向放大，hi/lo为每字节左/右像素重复两次的结果
+static inline void scale_16bytes_nearest(const uint8_t *src, uint8_t *dst, int scale) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    __m128i v = _mm_loadu_si128((const __m128i *)src);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+    __m128i lo = _mm_and_si128(v, mask);
+    hi = _mm_or_si128(hi, _mm_slli_epi16(hi, 4));
+    lo = _mm_or_si128(lo, _mm_slli_epi16(lo, 4));
+    __m128i a = _mm_unpacklo_epi8(hi, lo);
+    __m128i b = _mm_unpackhi_epi8(hi, lo);
+    if (scale == 2) {
+        _mm_storeu_si128((__m128i *)dst + 0, a);
+        _mm_storeu_si128((__m128i *)dst + 1, b);
+    } else if (scale == 4) {
+        _mm_storeu_si128((__m128i *)dst + 0, _mm_unpacklo_epi8(a, a));
+        _mm_storeu_si128((__m128i *)dst + 1, _mm_unpackhi_epi8(a, a));
+        _mm_storeu_si128((__m128i *)dst + 2, _mm_unpacklo_epi8(b, b));
+        _mm_storeu_si128((__m128i *)dst + 3, _mm_unpackhi_epi8(b, b));
+    } else {
+#if defined(__SSSE3__)
+        // 3倍: 每字节输出 hi, 原字节, lo 三字节交错
+        const int8_t _ = -1;
+        __m128i x0 = _mm_shuffle_epi8(hi, _mm_setr_epi8( 0, _, _, 1, _, _, 2, _, _, 3, _, _, 4, _, _, 5));
+        __m128i y0 = _mm_shuffle_epi8(v,  _mm_setr_epi8( _, 0, _, _, 1, _, _, 2, _, _, 3, _, _, 4, _, _));
+        __m128i z0 = _mm_shuffle_epi8(lo, _mm_setr_epi8( _, _, 0, _, _, 1, _, _, 2, _, _, 3, _, _, 4, _));
+        __m128i x1 = _mm_shuffle_epi8(hi, _mm_setr_epi8( _, _, 6, _, _, 7, _, _, 8, _, _, 9, _, _,10, _));
+        __m128i y1 = _mm_shuffle_epi8(v,  _mm_setr_epi8( 5, _, _, 6, _, _, 7, _, _, 8, _, _, 9, _, _,10));
+        __m128i z1 = _mm_shuffle_epi8(lo, _mm_setr_epi8( _, 5, _, _, 6, _, _, 7, _, _, 8, _, _, 9, _, _));
+        __m128i x2 = _mm_shuffle_epi8(hi, _mm_setr_epi8( _,11, _, _,12, _, _,13, _, _,14, _, _,15, _, _));
+        __m128i y2 = _mm_shuffle_epi8(v,  _mm_setr_epi8( _, _,11, _, _,12, _, _,13, _, _,14, _, _,15, _));
+        __m128i z2 = _mm_shuffle_epi8(lo, _mm_setr_epi8(10, _, _,11, _, _,12, _, _,13, _, _,14, _, _,15));
+        _mm_storeu_si128((__m128i *)dst + 0, _mm_or_si128(_mm_or_si128(x0, y0), z0));
+        _mm_storeu_si128((__m128i *)dst + 1, _mm_or_si128(_mm_or_si128(x1, y1), z1));
+        _mm_storeu_si128((__m128i *)dst + 2, _mm_or_si128(_mm_or_si128(x2, y2), z2));
+#else
+        for (int i = 0; i < 16; ++i) {
+            scale_byte_nearest(src[i], dst + i * 3, 3);
+        }
+#endif
+    }
+}
+#endif
+
+// 单行横向放大
+static void scale_row_nearest(const uint8_t *src, uint8_t *dst, int bytes, int scale) {
+    int i = 0;
+#if defined(__SSE2__)
+    // 最后一组与前一组重叠，结果相同，省去逐字节处理行尾
+    if (bytes >= 16) {
+        for (; i < bytes; i += 16) {
+            if (i > bytes - 16) i = bytes - 16;
+            scale_16bytes_nearest(src + i, dst + i * scale, scale);
+        }
+    }
+#endif
+    for (; i < bytes; ++i) {
+        scale_byte_nearest(src[i], dst + i * scale, scale);
+    }
+}
+
+// 最近邻整数倍放大(2/3/4倍)
+bool bmp_pixels_scale_nearest(const void *source, void *target, int width, int height, int scale) {
+    if (scale < 2 || scale > 4) return false;
+    const uint8_t *src = source;
+    uint8_t *dst = target;
+    int sourceBytes = width >> 1;
+    int targetBytes = sourceBytes * scale;
+    for (int y = 0; y < height; ++y) {
+        scale_row_nearest(src + y * sourceBytes, dst, sourceBytes, scale);
+        for (int i = 1; i < scale; ++i) {
+            memcpy(dst + i * targetBytes, dst, targetBytes);
+        }
+        dst += targetBytes * scale;
+    }
+    return true;
+}
+
+// 4bpp -> 每像素1字节
+static void unpack_pixels(const uint8_t *src, uint8_t *dst, int count) {
+    for (int i = 0; i < count; i += 2) {
+        dst[i] = src[i >> 1] >> 4;
+        dst[i + 1] = src[i >> 1] & 0x0F;
+    }
+}
+
+// 每像素1字节 -> 4bpp
+static void pack_pixels(const uint8_t *src, uint8_t *dst, int count) {
+    for (int i = 0; i < count; i += 2) {
+        dst[i >> 1] = (src[i] << 4) | src[i + 1];
+    }
+}
+
+// Scale2x(EPX)，边界外按边缘像素处理
+//   A      E0 E1
+// C P B -> E2 E3
+//   D
+static void scale2x(const uint8_t *src, uint8_t *dst, int width, int height) {
+    int dstWidth = width * 2;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *row = src + y * width;
+        const uint8_t *up = y > 0 ? row - width : row;
+        const uint8_t *down = y < height - 1 ? row + width : row;
+        uint8_t *out = dst + y * 2 * dstWidth;
+        for (int x = 0; x < width; ++x) {
+            uint8_t P = row[x];
+            uint8_t A = up[x];
+            uint8_t D = down[x];
+            uint8_t C = row[x > 0 ? x - 1 : x];
+            uint8_t B = row[x < width - 1 ? x + 1 : x];
+            uint8_t *e = out + x * 2;
+            if (A != D && C != B) {
+                e[0]            = C == A ? A : P;
+                e[1]            = A == B ? B : P;
+                e[dstWidth]     = D == C ? C : P;
+                e[dstWidth + 1] = B == D ? D : P;
+            } else {
+                e[0] = e[1] = e[dstWidth] = e[dstWidth + 1] = P;
+            }
+        }
+    }
+}
+
+// Scale3x，边界外按边缘像素处理
+// A B C      E0 E1 E2
+// D E F  ->  E3 E4 E5
+// G H I      E6 E7 E8
+static void scale3x(const uint8_t *src, uint8_t *dst, int width, int height) {
+    int dstWidth = width * 3;
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *row = src + y * width;
+        const uint8_t *up = y > 0 ? row - width : row;
+        const uint8_t *down = y < height - 1 ? row + width : row;
+        uint8_t *out = dst + y * 3 * dstWidth;
+        for (int x = 0; x < width; ++x) {
+            int l = x > 0 ? x - 1 : x;
+            int r = x < width - 1 ? x + 1 : x;
+            uint8_t A = up[l],   B = up[x],   C = up[r];
+            uint8_t D = row[l],  E = row[x],  F = row[r];
+            uint8_t G = down[l], H = down[x], I = down[r];
+            uint8_t *e0 = out + x * 3;
+            uint8_t *e3 = e0 + dstWidth;
+            uint8_t *e6 = e3 + dstWidth;
+            if (B != H && D != F) {
+                e0[0] = D == B ? D : E;
+                e0[1] = (D == B && E != C) || (B == F && E != A) ? B : E;
+                e0[2] = B == F ? F : E;
+                e3[0] = (D == B && E != G) || (D == H && E != A) ? D : E;
+                e3[1] = E;
+                e3[2] = (B == F && E != I) || (H == F && E != C) ? F : E;
+                e6[0] = D == H ? D : E;
+                e6[1] = (D == H && E != I) || (H == F && E != G) ? H : E;
+                e6[2] = H == F ? F : E;
+            } else {
+                e0[0] = e0[1] = e0[2] = E;
+                e3[0] = e3[1] = e3[2] = E;
+                e6[0] = e6[1] = e6[2] = E;
+            }
+        }
+    }
+}
+
+// 像素画边缘感知放大(2/3/4倍，4倍为两次Scale2x)
+// 按调色板索引比较像素，因此同色不同索引的像素视为不同
+bool bmp_pixels_scale_epx(const void *source, void *target, int width, int height, int scale) {
+    if (scale < 2 || scale > 4) return false;
+    int count = width * height;
+    int scaledCount = count * scale * scale;
+    // 4倍时中间结果(2倍)也放在scaled后部
+    uint8_t *pixels = malloc(count);
+    uint8_t *scaled = malloc(scale == 4 ? scaledCount + count * 4 : scaledCount);
+    if (pixels == NULL || scaled == NULL) {
+        free(pixels);
+        free(scaled);
+        return false;
+    }
+    unpack_pixels(source, pixels, count);
+    if (scale == 2) {
+        scale2x(pixels, scaled, width, height);
+    } else if (scale == 3) {
+        scale3x(pixels, scaled, width, height);
+    } else {
+        uint8_t *scaled2x = scaled + scaledCount;
+        scale2x(pixels, scaled2x, width, height);
+        scale2x(scaled2x, scaled, width * 2, height * 2);
+    }
+    pack_pixels(scaled, target, scaledCount);
+    free(pixels);
+    free(scaled);
+    return true;
+}
+
+// 高精度计时(微秒)
+static double timer_microseconds(void) {
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart * 1000000 / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000000 + now.tv_nsec / 1000.0;
+#endif
+}
+
+// 批量放大并计时，返回总耗时(微秒)，scale无效时返回负数
+double bmp_pixels_scale_frames(const void *const *sources, void *const *targets, int count,
+        int width, int height, int scale, bool epx) {
+    if (scale < 2 || scale > 4) return -1;
+    bool (*scaler)(const void *, void *, int, int, int) =
+        epx ? bmp_pixels_scale_epx : bmp_pixels_scale_nearest;
+    double begin = timer_microseconds();
+    for (int i = 0; i < count; ++i) {
+        scaler(sources[i], targets[i], width, height, scale);
+    }
+    return timer_microseconds() - begin;
+}
@@ -0,0 +1,15 @@
+#ifndef __scale_h__
+#define __scale_h__
+
+#include <stdbool.h>
+
+// 4bpp索引色图像整数倍放大，scale只支持2/3/4，其他值不处理并返回false
+// target需能容纳 (width * scale) * (height * scale) / 2 字节
+bool bmp_pixels_scale_nearest(const void *source, void *target, int width, int height, int scale);
+bool bmp_pixels_scale_epx(const void *source, void *target, int width, int height, int scale);
+
+// 依次放大count帧并返回总耗时(微秒)，scale无效时返回负数
+double bmp_pixels_scale_frames(const void *const *sources, void *const *targets, int count,
+    int width, int height, int scale, bool epx);
+
+#endif // __scale_h__